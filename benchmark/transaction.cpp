@@ -0,0 +1,70 @@
+// N repeated sets of a validating property with and without PropertyTransaction
+//
+//   g++ -std=c++17 -O2 -I.. transaction.cpp -o transaction && ./transaction [N]
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include "../cpp_property.h"
+
+class Entry
+{
+private:
+    std::string md5_;
+
+public:
+    Property<const std::string&> md5_str = {
+        [this]() -> const std::string& { return md5_; },
+        [this](const std::string& value) {
+            constexpr auto Hexcheck = [](const auto c) { return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'); };
+            const auto check = value.size() == 32 && std::all_of(value.begin(), value.end(), Hexcheck);
+            if (!check)
+            {
+                throw std::invalid_argument("");
+            }
+            md5_ = value;
+        }};
+};
+
+int main(int argc, char* argv[])
+{
+    const auto n = argc > 1 ? std::stoi(argv[1]) : 1000000;
+    const std::string hash = "a95c530a7af5f492a74499e70578d150";
+    auto entry = Entry();
+
+    const auto direct = [&]() {
+        for (int i = 0; i < n; ++i)
+        {
+            entry.md5_str = hash;  // n validations
+        }
+    };
+    const auto transactional = [&]() {
+        PropertyTransaction transaction;
+        for (int i = 0; i < n; ++i)
+        {
+            entry.md5_str = hash;  // n stagings
+        }
+        transaction.Commit();  // 1 validation
+    };
+    using Ms = std::chrono::duration<double, std::milli>;
+    const auto measure = [](const auto& f) {
+        const auto start = std::chrono::steady_clock::now();
+        f();
+        return Ms(std::chrono::steady_clock::now() - start);
+    };
+
+    // warm-up, so that neither loop pays the cold-start cost
+    direct();
+    transactional();
+
+    const auto direct_time = measure(direct);
+    const auto transaction_time = measure(transactional);
+
+    std::cout << "N:           " << n << std::endl;
+    std::cout << "direct:      " << direct_time.count() << " ms" << std::endl;
+    std::cout << "transaction: " << transaction_time.count() << " ms" << std::endl;
+    std::cout << "ratio:       " << direct_time / transaction_time << std::endl;
+    return 0;
+}
@@ -1,7 +1,14 @@
 #include <cassert>
+#include <exception>
 #include <functional>
 #include <iostream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
 #include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 enum class PropertyMode
 {
@@ -34,6 +41,188 @@ struct isPropertyIgnRef : isProperty<std::remove_reference_t<T>>
 template <class T>
 constexpr bool isPropertyIgnRefV = isPropertyIgnRef<T>::value;
 
+/**
+ * @brief   Thrown by PropertyTransaction::Commit() when a property could not be restored
+ *
+ * The setter failure which caused the rollback is nested (std::rethrow_if_nested).
+ */
+class PropertyRollbackError : public std::runtime_error
+{
+public:
+    using std::runtime_error::runtime_error;
+};
+
+/**
+ * @brief   Transaction scope for properties
+ *
+ * Stages the setters of Property/AutoProperty on the current thread until Commit(). Transactions cannot be nested.
+ */
+class PropertyTransaction
+{
+public:
+    PropertyTransaction()
+    {
+        if (current_)
+        {
+            throw std::logic_error("Nested property transactions are not supported");
+        }
+        current_ = this;
+    }
+    ~PropertyTransaction() { Finish(); }
+
+    PropertyTransaction(const PropertyTransaction&) = delete;
+    PropertyTransaction(PropertyTransaction&&) = delete;
+    PropertyTransaction& operator=(const PropertyTransaction&) = delete;
+    PropertyTransaction& operator=(PropertyTransaction&&) = delete;
+
+    // apply the staged values (the transaction is finished even if a setter throws)
+    void Commit()
+    {
+        if (!IsActive())
+        {
+            return;
+        }
+        Finish();
+
+        std::size_t applied = 0;
+        try
+        {
+            for (; applied < staged_.size(); ++applied)
+            {
+                staged_[applied]->Apply();
+            }
+        }
+        catch (...)
+        {
+            auto restored = true;
+            while (applied > 0)
+            {
+                restored = staged_[--applied]->Restore() && restored;
+            }
+            if (!restored)
+            {
+                std::throw_with_nested(PropertyRollbackError("Property transaction was partially committed"));
+            }
+            throw;
+        }
+    }
+
+    // discard the staged values
+    void Rollback() noexcept { Finish(); }
+
+    bool IsActive() const noexcept { return current_ == this; }
+
+private:
+    template <class...>
+    friend class PropertyBase;
+
+    static PropertyTransaction* Current() noexcept { return current_; }
+
+    template <class P>
+    typename P::ValueType& Stage(const P& property, const typename P::ValueType& value)
+    {
+        if (auto* staged = Find(property))
+        {
+            *staged = value;
+            return *staged;
+        }
+        // index_ refers to staged_ only once the value has been stored
+        auto node = std::make_unique<Staged<P>>(property, value);
+        auto& staged = node->value_;
+        staged_.push_back(std::move(node));
+        try
+        {
+            index_.emplace(Key(property), staged_.size() - 1);
+        }
+        catch (...)
+        {
+            staged_.pop_back();
+            throw;
+        }
+        return staged;
+    }
+
+    template <class P>
+    typename P::ValueType* Find(const P& property) const noexcept
+    {
+        const auto it = index_.find(Key(property));
+        return it == index_.end() ? nullptr : &static_cast<Staged<P>&>(*staged_[it->second]).value_;
+    }
+
+    struct StagedBase
+    {
+        virtual ~StagedBase() = default;
+        virtual void Apply() = 0;
+        virtual bool Restore() noexcept = 0;
+    };
+
+    template <class P>
+    struct Staged : StagedBase
+    {
+        using ValueType = typename P::ValueType;
+
+        const P& property_;
+        ValueType value_;
+        std::optional<ValueType> previous_;
+
+        Staged(const P& property, const ValueType& value) : property_(property), value_(value) {}
+
+        void Apply() override
+        {
+            if constexpr (P::Restorable)
+            {
+                previous_.emplace(property_.Load());
+            }
+            property_.Store(value_);
+        }
+        // true if the previous value has been written back
+        bool Restore() noexcept override
+        {
+            if (!previous_)
+            {
+                return false;
+            }
+            try
+            {
+                property_.Store(*previous_);
+                return true;
+            }
+            catch (...)
+            {
+                return false;
+            }
+        }
+    };
+
+    // a property and the first member of its value share the address, so the type is part of the key
+    // (identified by the address of a per-type tag, which is cheaper to compare than std::type_index)
+    using KeyType = std::pair<const void*, const void*>;
+    struct KeyHash
+    {
+        std::size_t operator()(const KeyType& key) const noexcept { return std::hash<const void*>()(key.first); }
+    };
+
+    template <class P>
+    static KeyType Key(const P& property) noexcept
+    {
+        static constexpr char type_tag = 0;
+        return {&property, &type_tag};
+    }
+
+    void Finish() noexcept
+    {
+        if (current_ == this)
+        {
+            current_ = nullptr;
+        }
+    }
+
+    inline static thread_local PropertyTransaction* current_ = nullptr;
+
+    std::vector<std::unique_ptr<StagedBase>> staged_;
+    std::unordered_map<KeyType, std::size_t, KeyHash> index_;
+};
+
 template <template <typename, PropertyMode> class D, typename T, PropertyMode Mode>
 class PropertyBase<D<T, Mode>>
 {
@@ -60,6 +249,7 @@ class PropertyBase<D<T, Mode>>
 public:
     using ValueType = std::remove_cv_t<std::remove_reference_t<T>>;  // std::remove_cvref_t for C++20
     using ReturnType = T;
+    static constexpr PropertyMode AccessMode = Mode;
 
     // copy constructors are prohibited
     PropertyBase(const PropertyBase&) = delete;
@@ -102,6 +292,35 @@ protected:
         static_assert(Mode != PropertyMode::GetOnly, "Get-only property cannot set the value");
     }
 
+    // values which cannot be copied are never staged (the setter is called directly)
+    static constexpr bool Stageable = std::is_copy_constructible_v<ValueType> && std::is_copy_assignable_v<ValueType>;
+
+    // value staged by the active transaction (nullptr if none)
+    ValueType* StagedValue() const noexcept
+    {
+        if constexpr (Stageable)
+        {
+            auto* transaction = PropertyTransaction::Current();
+            return transaction ? transaction->Find(Derived()) : nullptr;
+        }
+        return nullptr;
+    }
+
+    // stage the value if a transaction is active
+    bool StageValue(const ValueType& value) const
+    {
+        if constexpr (Stageable)
+        {
+            auto* transaction = PropertyTransaction::Current();
+            if (transaction)
+            {
+                transaction->Stage(Derived(), value);
+                return true;
+            }
+        }
+        return false;
+    }
+
 public:
 #pragma region lvalue operators
     decltype(auto) operator[](std::size_t i) const& { return Derived()()[i]; }
@@ -527,6 +746,7 @@ class Property : public PropertyBase<Property<T, Mode>>
 {
     using Base = PropertyBase<Property<T, Mode>>;
     friend Base;
+    friend class PropertyTransaction;
 
 public:
     using ValueType = typename Base::ValueType;
@@ -569,19 +789,33 @@ public:
     };
 
 private:
+    // a set-only property has no getter to save the previous value with
+    static constexpr bool Restorable = Mode != PropertyMode::SetOnly;
+
     const std::function<ReturnType()> getter_ = std::function<ReturnType()>();
     const std::function<void(const ValueType&)> setter_ = std::function<void(const ValueType&)>();
 
     ReturnType Get() const
     {
         Base::CheckGetAccess();
-        return getter_();
+        if (auto* staged = Base::StagedValue())
+        {
+            return *staged;
+        }
+        return Load();
     }
     void Set(const ValueType& value) const
     {
         Base::CheckSetAccess();
-        setter_(value);
+        if (!Base::StageValue(value))
+        {
+            Store(value);
+        }
     }
+
+    // direct access bypassing the transaction
+    ReturnType Load() const { return getter_(); }
+    void Store(const ValueType& value) const { setter_(value); }
 };
 
 /**
@@ -596,6 +830,7 @@ class AutoProperty : public PropertyBase<AutoProperty<T, Mode>>
 private:
     using Base = PropertyBase<AutoProperty<T, Mode>>;
     friend Base;
+    friend class PropertyTransaction;
 
 public:
     using ValueType = typename Base::ValueType;
@@ -603,6 +838,9 @@ public:
     using ReturnTypeR = std::remove_reference_t<ReturnType>;
 
 private:
+    // the entity is readable internally in every mode
+    static constexpr bool Restorable = true;
+
     mutable ValueType entity_;
 
 public:
@@ -646,16 +884,31 @@ private:
     ReturnType Get() const&
     {
         Base::CheckGetAccess();
+        if (auto* staged = Base::StagedValue())
+        {
+            return *staged;
+        }
         return entity_;
     }
     ReturnTypeR Get() &&
     {
         Base::CheckGetAccess();
+        if (auto* staged = Base::StagedValue())
+        {
+            return *staged;  // the staged value is still needed at commit
+        }
         return std::move(entity_);
     }
     void Set(const ValueType& value) const
     {
         Base::CheckSetAccess();
-        entity_ = value;
+        if (!Base::StageValue(value))
+        {
+            Store(value);
+        }
     }
+
+    // direct access bypassing the transaction
+    ReturnType Load() const { return entity_; }
+    void Store(const ValueType& value) const { entity_ = value; }
 };